@@ -0,0 +1,96 @@
+/*
+ * CORESAMPLES.H	Sample sets for the core tools.
+ *
+ * Owns structure-of-arrays storage for packets and derived parameters and
+ * fills it with input distributions like the ones seen in renders.
+ */
+#ifndef CORESAMPLES_H
+#define CORESAMPLES_H
+
+#include "../UnrealShader/UnrealCore.h"
+
+#include <stdlib.h>
+#include <vector>
+
+
+namespace Unreal_Shader {
+
+	class CoreSamples
+	{
+	public:
+		enum { NUM_IN = 14, NUM_OUT = 30 };
+
+		unsigned		 count;
+		std::vector<float>	 inData;
+		std::vector<float>	 outData;
+		UnrealPacketArrays	 in;
+		UnrealParmsArrays	 out;
+
+		CoreSamples(unsigned n) : count(n), inData(NUM_IN * n), outData(NUM_OUT * n)
+		{
+			float	*p = &inData[0];
+
+			for (int k = 0; k < 3; k++)
+			{
+				in.baseColor[k] = p + k * n;
+				in.emissiveColor[k] = p + (6 + k) * n;
+				in.auxRGB[k] = p + (11 + k) * n;
+			}
+
+			in.metallic = p + 3 * n;
+			in.specular = p + 4 * n;
+			in.roughness = p + 5 * n;
+			in.uOpacity = p + 9 * n;
+			in.tessMultiplier = p + 10 * n;
+
+			// UnrealParmsArrays is nothing but NUM_OUT float pointers.
+			static_assert(sizeof(UnrealParmsArrays) == NUM_OUT * sizeof(float *), "UnrealParmsArrays layout");
+			float	**o = &out.diffCol[0];
+
+			for (int k = 0; k < NUM_OUT; k++)
+				o[k] = &outData[0] + k * n;
+		}
+
+		float *		Input (int k)	{ return &inData[0] + k * count; }
+		float *		Output (int k)	{ return &outData[0] + k * count; }
+
+		/*
+		* Uniform values with a margin outside [0,1] so the clamps are
+		* exercised as well.
+		*/
+		void
+		FillRandom (unsigned seed)
+		{
+			srand(seed);
+			for (size_t i = 0; i < inData.size(); i++)
+				inData[i] = -0.1f + 1.2f * (float)rand() / RAND_MAX;
+		}
+
+		/*
+		* A dense sweep over roughness, specular and metallic, the inputs
+		* that go through the curves. Other inputs are random.
+		*/
+		void
+		FillSweep (unsigned seed)
+		{
+			FillRandom(seed);
+
+			unsigned	 side = 1;
+
+			while ((side + 1) * (side + 1) * (side + 1) <= count)
+				side++;
+
+			for (unsigned i = 0; i < count; i++)
+			{
+				unsigned	 a = i % side, b = (i / side) % side, c = (i / side / side) % side;
+
+				in.roughness[i] = (float)a / (side - 1);
+				in.specular[i] = (float)b / (side - 1);
+				in.metallic[i] = (float)c / (side - 1);
+			}
+		}
+	};
+
+};	// END namespace
+
+#endif	// CORESAMPLES_H
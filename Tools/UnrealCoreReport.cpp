@@ -0,0 +1,199 @@
+/*
+ * UNREALCOREREPORT.CPP	Accuracy and speed report for the core kernels.
+ *
+ * Compares each approximate kernel against the exact remap over the same
+ * inputs and prints the maximum absolute error per output, followed by the
+ * time per sample of every kernel.
+ */
+#include "CoreSamples.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+
+using namespace Unreal_Shader;
+
+static const char *outNames[CoreSamples::NUM_OUT] = {
+	"diffCol.R", "diffCol.G", "diffCol.B",
+	"specCol.R", "specCol.G", "specCol.B",
+	"reflCol.R", "reflCol.G", "reflCol.B",
+	"lumiCol.R", "lumiCol.G", "lumiCol.B",
+	"subsCol.R", "subsCol.G", "subsCol.B",
+	"tranCol.R", "tranCol.G", "tranCol.B",
+	"diffAmt", "specAmt", "rough", "specExpU", "specExpV",
+	"reflAmt", "tranAmt", "dissAmt", "specFres", "reflFres",
+	"driverA", "driverB"
+};
+
+typedef void (*BatchFn) (const UnrealPacketArrays &, const UnrealParmsArrays &, unsigned);
+
+/*
+* Per-sample entry point run over the arrays, as the plugin would.
+*/
+static void
+SampleFastEvaluate (const UnrealPacketArrays &in, const UnrealParmsArrays &out, unsigned count)
+{
+	LXpUnreal	 sp;
+	UnrealParms	 parms;
+
+	for (unsigned i = 0; i < count; i++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			sp.baseColor[k] = in.baseColor[k][i];
+			sp.emissiveColor[k] = in.emissiveColor[k][i];
+			sp.auxRGB[k] = in.auxRGB[k][i];
+		}
+
+		sp.metallic = in.metallic[i];
+		sp.specular = in.specular[i];
+		sp.roughness = in.roughness[i];
+		sp.uOpacity = in.uOpacity[i];
+		sp.tessMultiplier = in.tessMultiplier[i];
+
+		CoreShaderSampleFast(&sp, &parms);
+
+		for (int k = 0; k < 3; k++)
+		{
+			out.diffCol[k][i] = parms.diffCol[k];
+			out.specCol[k][i] = parms.specCol[k];
+			out.reflCol[k][i] = parms.reflCol[k];
+			out.lumiCol[k][i] = parms.lumiCol[k];
+		}
+
+		out.diffAmt[i] = parms.diffAmt;
+		out.specAmt[i] = parms.specAmt;
+		out.rough[i] = parms.rough;
+		out.specExpU[i] = parms.specExpU;
+		out.specExpV[i] = parms.specExpV;
+		out.reflAmt[i] = parms.reflAmt;
+		out.dissAmt[i] = parms.dissAmt;
+		out.specFres[i] = parms.specFres;
+		out.reflFres[i] = parms.reflFres;
+		out.driverA[i] = parms.driverA;
+		out.driverB[i] = parms.driverB;
+	}
+}
+
+static struct {
+	const char	*name;
+	BatchFn		 fn;
+} kernels[] = {
+	{ "exact", CoreShaderEvaluate },
+	{ "sample-fast", SampleFastEvaluate },
+	{ "sse", CoreShaderEvaluateSSE },
+#ifdef __AVX2__
+	{ "avx2", CoreShaderEvaluateAVX2 },
+#endif
+	{ 0, 0 }
+};
+
+/*
+* Run a kernel on a private copy of the inputs, since the packet is
+* clamped in place.
+*/
+static void
+RunKernel (BatchFn fn, const CoreSamples &src, CoreSamples &dst)
+{
+	dst.inData = src.inData;
+	fn(dst.in, dst.out, dst.count);
+}
+
+static void
+ReportAccuracy (unsigned count)
+{
+	CoreSamples	 src(count), ref(count), test(count);
+
+	src.FillSweep(1);
+	RunKernel(CoreShaderEvaluate, src, ref);
+
+	printf("Maximum absolute error against the exact shader mode remap, %u samples\n\n", count);
+	printf("%-12s", "output");
+	for (int j = 1; kernels[j].name; j++)
+		printf(" %12s", kernels[j].name);
+	printf("\n");
+
+	double	 err[8][CoreSamples::NUM_OUT];
+
+	for (int j = 1; kernels[j].name; j++)
+	{
+		RunKernel(kernels[j].fn, src, test);
+
+		for (int k = 0; k < CoreSamples::NUM_OUT; k++)
+		{
+			err[j][k] = 0;
+			if (k >= 12 && k < 18)
+				continue;		// subsCol and tranCol are baking only
+
+			if (k == 24)
+				continue;		// tranAmt as well
+
+			for (unsigned i = 0; i < count; i++)
+			{
+				double	 d = fabs((double) test.Output(k)[i] - ref.Output(k)[i]);
+
+				if (d > err[j][k])
+					err[j][k] = d;
+			}
+		}
+	}
+
+	for (int k = 0; k < CoreSamples::NUM_OUT; k++)
+	{
+		if ((k >= 12 && k < 18) || k == 24)
+			continue;
+
+		printf("%-12s", outNames[k]);
+		for (int j = 1; kernels[j].name; j++)
+			printf(" %12.3g", err[j][k]);
+		printf("\n");
+	}
+	printf("\n");
+}
+
+static void
+ReportSpeed (unsigned count, int passes)
+{
+	CoreSamples	 src(count), dst(count);
+
+	src.FillRandom(2);
+
+	printf("Time per sample, %u samples x %d passes\n\n", count, passes);
+
+	for (int j = 0; kernels[j].name; j++)
+	{
+		double	 best = 1e30;
+
+		for (int p = 0; p < passes; p++)
+		{
+			dst.inData = src.inData;
+
+			std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+			kernels[j].fn(dst.in, dst.out, count);
+			std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+			double	 ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / count;
+
+			if (ns < best)
+				best = ns;
+		}
+
+		printf("%-12s %8.2f ns/sample\n", kernels[j].name, best);
+	}
+	printf("\n");
+}
+
+int
+main (int argc, char **argv)
+{
+	unsigned	 count = 1 << 20;
+
+	if (argc > 1)
+		count = (unsigned) atoi(argv[1]);
+
+	ReportAccuracy(count);
+	ReportSpeed(count, 5);
+	return 0;
+}
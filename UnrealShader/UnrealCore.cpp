@@ -0,0 +1,217 @@
+/*
+ * UNREALCORE.CPP	Unreal to MODO parameter remapping.
+ *
+ */
+#include "UnrealCore.h"
+
+#include <math.h>
+
+
+namespace Unreal_Shader {
+
+	void CoreClampPacket(LXpUnreal *sp)
+	{
+		sp->baseColor[0] = UNREAL_CLAMP(sp->baseColor[0], 0, 1);
+		sp->baseColor[1] = UNREAL_CLAMP(sp->baseColor[1], 0, 1);
+		sp->baseColor[2] = UNREAL_CLAMP(sp->baseColor[2], 0, 1);
+
+		sp->metallic = UNREAL_CLAMP(sp->metallic, 0, 1);
+		sp->specular = UNREAL_CLAMP(sp->specular, 0, 1);
+		sp->roughness = UNREAL_CLAMP(sp->roughness, 0, 1);
+
+		sp->emissiveColor[0] = UNREAL_CLAMP(sp->emissiveColor[0], 0, 1);
+		sp->emissiveColor[1] = UNREAL_CLAMP(sp->emissiveColor[1], 0, 1);
+		sp->emissiveColor[2] = UNREAL_CLAMP(sp->emissiveColor[2], 0, 1);
+
+		sp->uOpacity = UNREAL_CLAMP(sp->uOpacity, 0, 1);
+		sp->tessMultiplier = UNREAL_CLAMP(sp->tessMultiplier, 0, 1);
+
+		sp->auxRGB[0] = UNREAL_CLAMP(sp->auxRGB[0], 0, 1);
+		sp->auxRGB[1] = UNREAL_CLAMP(sp->auxRGB[1], 0, 1);
+		sp->auxRGB[2] = UNREAL_CLAMP(sp->auxRGB[2], 0, 1);
+	}
+
+	/*
+	* Approximate the Unreal look with the physical MODO material.
+	*/
+	void CoreShaderSample(LXpUnreal *sp, UnrealParms *parms)
+	{
+		CoreClampPacket(sp);
+
+		float mo = UNREAL_CLAMP(sp->specular * 2, 0, 1);				// Micro occlusion darkening.
+
+		parms->specFres = 1;
+		parms->reflFres = 1;
+
+		sp->metallic = pow(sp->metallic, 3);
+
+		double rc1[3] = { sp->baseColor[0], sp->baseColor[1], sp->baseColor[2] };
+		double rc3[3];
+		for (int i = 0; i < 3; i++)
+		{
+			parms->diffCol[i] = rc1[i] * mo;								// Diffuse color.
+			rc3[i] = LERP(1.0, 1 - rc1[i], 0.5);							// Diffuse color independent, always white specular.
+			parms->specCol[i] = LERP(rc3[i], rc1[i], sp->metallic);		// Blend from white to colored specular.
+			parms->reflCol[i] = LERP(rc3[i], rc1[i], sp->metallic);		// Blending from white to colored reflection.
+			parms->lumiCol[i] = sp->emissiveColor[i];						// Emissive color.
+		}
+
+		parms->diffAmt = LERP(1.0, 0.5, sp->metallic);					// Diffuse amount.
+		float sa1 = 1 - pow(sp->roughness, 0.5);
+		float sa2 = LERP(0.1, 1, sa1);
+		float sa11 = 1 - pow(sp->roughness, 0.7);
+		float sa12 = LERP(0.05, 0.1, sa11) * (sp->specular * 2);
+		parms->specAmt = LERP(sa12, sa2, sp->metallic);					// Specular amount.
+
+		float sr1 = UNREAL_CLAMP(sp->roughness * 4, 0, 1);
+		float sr2 = LERP(0.08, 0.008, sr1);
+		float sr3 = pow(sp->roughness, sr2);
+		parms->rough = sr3;												// Roughness.
+		float sr4 = LERP(sr3, pow(sr3, 0.5), sp->metallic);
+		parms->specExpU = LERP(10000, 1, sr4);							// Specular exponent U.
+		parms->specExpV = LERP(10000, 1, sr4);							// Specular exponent V.
+
+		float ra1 = LERP(1, 0.5, sp->roughness);
+		float ra2 = LERP(0, 1, pow(sp->specular, 2.248) * 0.19);		// Should be 0.04 at 0.5.
+		parms->reflAmt = LERP(ra2, ra1, sp->metallic);					// Reflection amount.
+		parms->dissAmt = 1 - sp->uOpacity;								// Dissolve.
+		parms->driverA = sp->specular;									// Driver A.
+		parms->driverB = sp->tessMultiplier;							// Driver B.
+	}
+
+	/*
+	* Pack the raw Unreal values into the render outputs for baking.
+	*/
+	void CoreBakingSample(LXpUnreal *sp, UnrealParms *parms)
+	{
+		CoreClampPacket(sp);
+
+		parms->specFres = 0;
+		parms->reflFres = 0;
+
+		for (int i = 0; i < 3; i++)
+		{
+			parms->diffCol[i] = sp->baseColor[i];
+			parms->specCol[i] = sp->auxRGB[i];
+			parms->reflCol[i] = 1;
+			parms->lumiCol[i] = sp->emissiveColor[i];
+		}
+
+		parms->subsCol[0] = sp->metallic;
+		parms->subsCol[1] = sp->roughness;
+		parms->subsCol[2] = sp->specular;
+		parms->tranCol[0] = sp->uOpacity;
+		parms->tranCol[1] = sp->tessMultiplier;
+		parms->tranCol[2] = 0;
+
+		parms->diffAmt = 1;
+		parms->specAmt = 1;
+		parms->rough = sp->roughness;
+		parms->reflAmt = sp->metallic;
+		parms->tranAmt = sp->uOpacity;
+		parms->driverA = sp->specular;
+		parms->driverB = sp->tessMultiplier;
+	}
+
+	/*
+	* Move one sample between the arrays and the packet layout.
+	*/
+	static void GatherPacket(const UnrealPacketArrays &in, unsigned i, LXpUnreal *sp)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			sp->baseColor[k] = in.baseColor[k][i];
+			sp->emissiveColor[k] = in.emissiveColor[k][i];
+			sp->auxRGB[k] = in.auxRGB[k][i];
+		}
+
+		sp->metallic = in.metallic[i];
+		sp->specular = in.specular[i];
+		sp->roughness = in.roughness[i];
+		sp->uOpacity = in.uOpacity[i];
+		sp->tessMultiplier = in.tessMultiplier[i];
+	}
+
+	static void ScatterPacket(const UnrealPacketArrays &in, unsigned i, const LXpUnreal *sp)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			in.baseColor[k][i] = sp->baseColor[k];
+			in.emissiveColor[k][i] = sp->emissiveColor[k];
+			in.auxRGB[k][i] = sp->auxRGB[k];
+		}
+
+		in.metallic[i] = sp->metallic;
+		in.specular[i] = sp->specular;
+		in.roughness[i] = sp->roughness;
+		in.uOpacity[i] = sp->uOpacity;
+		in.tessMultiplier[i] = sp->tessMultiplier;
+	}
+
+	void CoreShaderEvaluate(const UnrealPacketArrays &in, const UnrealParmsArrays &out, unsigned count)
+	{
+		LXpUnreal	 sp;
+		UnrealParms	 parms;
+
+		for (unsigned i = 0; i < count; i++)
+		{
+			GatherPacket(in, i, &sp);
+			CoreShaderSample(&sp, &parms);
+			ScatterPacket(in, i, &sp);
+
+			for (int k = 0; k < 3; k++)
+			{
+				out.diffCol[k][i] = parms.diffCol[k];
+				out.specCol[k][i] = parms.specCol[k];
+				out.reflCol[k][i] = parms.reflCol[k];
+				out.lumiCol[k][i] = parms.lumiCol[k];
+			}
+
+			out.diffAmt[i] = parms.diffAmt;
+			out.specAmt[i] = parms.specAmt;
+			out.rough[i] = parms.rough;
+			out.specExpU[i] = parms.specExpU;
+			out.specExpV[i] = parms.specExpV;
+			out.reflAmt[i] = parms.reflAmt;
+			out.dissAmt[i] = parms.dissAmt;
+			out.specFres[i] = parms.specFres;
+			out.reflFres[i] = parms.reflFres;
+			out.driverA[i] = parms.driverA;
+			out.driverB[i] = parms.driverB;
+		}
+	}
+
+	void CoreBakingEvaluate(const UnrealPacketArrays &in, const UnrealParmsArrays &out, unsigned count)
+	{
+		LXpUnreal	 sp;
+		UnrealParms	 parms;
+
+		for (unsigned i = 0; i < count; i++)
+		{
+			GatherPacket(in, i, &sp);
+			CoreBakingSample(&sp, &parms);
+			ScatterPacket(in, i, &sp);
+
+			for (int k = 0; k < 3; k++)
+			{
+				out.diffCol[k][i] = parms.diffCol[k];
+				out.specCol[k][i] = parms.specCol[k];
+				out.reflCol[k][i] = parms.reflCol[k];
+				out.lumiCol[k][i] = parms.lumiCol[k];
+				out.subsCol[k][i] = parms.subsCol[k];
+				out.tranCol[k][i] = parms.tranCol[k];
+			}
+
+			out.diffAmt[i] = parms.diffAmt;
+			out.specAmt[i] = parms.specAmt;
+			out.rough[i] = parms.rough;
+			out.reflAmt[i] = parms.reflAmt;
+			out.tranAmt[i] = parms.tranAmt;
+			out.specFres[i] = parms.specFres;
+			out.reflFres[i] = parms.reflFres;
+			out.driverA[i] = parms.driverA;
+			out.driverB[i] = parms.driverB;
+		}
+	}
+
+};	// END namespace
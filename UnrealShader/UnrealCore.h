@@ -0,0 +1,130 @@
+/*
+ * UNREALCORE.H	Unreal to MODO parameter remapping.
+ *
+ * This is the part of the shader that does not depend on the SDK, so it can
+ * be profiled and checked without a MODO host.
+ */
+#ifndef UNREALCORE_H
+#define UNREALCORE_H
+
+#ifndef LERP
+	#define LERP(x,y,a)	((x) + (a) * ((y) - (x)))
+#endif
+
+#define UNREAL_CLAMP(a,b,c)	((a) < (b) ? (b) : ((a) > (c) ? (c) : (a)))
+
+
+namespace Unreal_Shader {
+
+	/*
+	* Layout of the Unreal packet. These are the values carried through the
+	* shading pipe from the material to the shader.
+	*/
+	typedef struct st_LXpUnreal
+	{
+		float	baseColor[3];
+		float metallic;
+		float specular;
+		float roughness;
+		float	emissiveColor[3];
+		float uOpacity;
+		float tessMultiplier;
+		float	auxRGB[3];
+	} LXpUnreal;
+
+	/*
+	* Sample parameters derived from the packet. The names match the fields
+	* of LXpSampleParms, driverA and driverB go to LXpSampleDriver.
+	*/
+	typedef struct st_UnrealParms
+	{
+		float	diffCol[3];
+		float	specCol[3];
+		float	reflCol[3];
+		float	lumiCol[3];
+		float	subsCol[3];
+		float	tranCol[3];
+		float	diffAmt;
+		float	specAmt;
+		float	rough;
+		float	specExpU;
+		float	specExpV;
+		float	reflAmt;
+		float	tranAmt;
+		float	dissAmt;
+		float	specFres;
+		float	reflFres;
+		float	driverA;
+		float	driverB;
+	} UnrealParms;
+
+	/*
+	* Structure of arrays versions of the above, for evaluating many samples
+	* in one call. Every pointer must address 'count' floats.
+	*/
+	typedef struct st_UnrealPacketArrays
+	{
+		float	*baseColor[3];
+		float	*metallic;
+		float	*specular;
+		float	*roughness;
+		float	*emissiveColor[3];
+		float	*uOpacity;
+		float	*tessMultiplier;
+		float	*auxRGB[3];
+	} UnrealPacketArrays;
+
+	typedef struct st_UnrealParmsArrays
+	{
+		float	*diffCol[3];
+		float	*specCol[3];
+		float	*reflCol[3];
+		float	*lumiCol[3];
+		float	*subsCol[3];
+		float	*tranCol[3];
+		float	*diffAmt;
+		float	*specAmt;
+		float	*rough;
+		float	*specExpU;
+		float	*specExpV;
+		float	*reflAmt;
+		float	*tranAmt;
+		float	*dissAmt;
+		float	*specFres;
+		float	*reflFres;
+		float	*driverA;
+		float	*driverB;
+	} UnrealParmsArrays;
+
+	/*
+	* The packet is clamped in place, the same as the shader does before it
+	* reads it, and shader mode also stores the cubed metallic back.
+	*
+	* Shader mode sets: diffCol, specCol, reflCol, lumiCol, diffAmt, specAmt,
+	* rough, specExpU/V, reflAmt, dissAmt, spec/reflFres and the drivers.
+	* Baking mode sets: diffCol, specCol, reflCol, lumiCol, subsCol, tranCol,
+	* diffAmt, specAmt, rough, reflAmt, tranAmt, spec/reflFres and the drivers.
+	*/
+	void	CoreClampPacket (LXpUnreal *sp);
+	void	CoreShaderSample (LXpUnreal *sp, UnrealParms *parms);
+	void	CoreBakingSample (LXpUnreal *sp, UnrealParms *parms);
+
+	void	CoreShaderEvaluate (const UnrealPacketArrays &in, const UnrealParmsArrays &out, unsigned count);
+	void	CoreBakingEvaluate (const UnrealPacketArrays &in, const UnrealParmsArrays &out, unsigned count);
+
+	/*
+	* Approximate shader mode remap (UnrealCoreSIMD.cpp). The batch versions
+	* process 4 (SSE) or 8 (AVX2) samples at once, the AVX2 one is only there
+	* when the file is compiled with AVX2 enabled. CoreShaderEvaluateFast
+	* picks the widest one available.
+	*/
+	void	CoreShaderSampleFast (LXpUnreal *sp, UnrealParms *parms);
+	void	CoreShaderEvaluateSSE (const UnrealPacketArrays &in, const UnrealParmsArrays &out, unsigned count);
+#ifdef __AVX2__
+	void	CoreShaderEvaluateAVX2 (const UnrealPacketArrays &in, const UnrealParmsArrays &out, unsigned count);
+#endif
+	void	CoreShaderEvaluateFast (const UnrealPacketArrays &in, const UnrealParmsArrays &out, unsigned count);
+
+};	// END namespace
+
+#endif	// UNREALCORE_H
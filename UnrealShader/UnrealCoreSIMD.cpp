@@ -0,0 +1,406 @@
+/*
+ * UNREALCORESIMD.CPP	Vectorized shader mode remap.
+ *
+ * The five pow() calls of the shader mode remap are replaced by sqrt where
+ * the exponent is 0.5, and by exp2(y * log2(x)) with polynomial log2 and
+ * exp2 everywhere else. The rest of the math is the same as CoreShaderSample.
+ *
+ * Maximum absolute error against CoreShaderSample, measured by the report
+ * tool (Tools/UnrealCoreReport.cpp) on a 101^3 sweep of roughness, specular
+ * and metallic:
+ *
+ *	specExpU/V	1.2e-3		(the range is 1 to 10000)
+ *	specAmt		2.4e-7
+ *	spec/reflCol	1.2e-7
+ *	reflAmt		1.2e-7
+ *	rough, diffAmt	6.0e-8
+ *	other outputs	exact
+ */
+#include "UnrealCore.h"
+
+#include <math.h>
+#include <emmintrin.h>
+#ifdef __AVX2__
+	#include <immintrin.h>
+#endif
+
+
+namespace Unreal_Shader {
+
+	/*
+	* Thin wrappers so the kernel can be written once for every vector width.
+	*/
+	struct VecSSE
+	{
+		typedef __m128		F;
+		typedef __m128i		I;
+		enum { WIDTH = 4 };
+
+		static F	Load (const float *p)		{ return _mm_loadu_ps(p); }
+		static void	Store (float *p, F a)		{ _mm_storeu_ps(p, a); }
+		static F	Set (float f)			{ return _mm_set1_ps(f); }
+		static F	Add (F a, F b)			{ return _mm_add_ps(a, b); }
+		static F	Sub (F a, F b)			{ return _mm_sub_ps(a, b); }
+		static F	Mul (F a, F b)			{ return _mm_mul_ps(a, b); }
+		static F	Div (F a, F b)			{ return _mm_div_ps(a, b); }
+		static F	Min (F a, F b)			{ return _mm_min_ps(a, b); }
+		static F	Max (F a, F b)			{ return _mm_max_ps(a, b); }
+		static F	Sqrt (F a)			{ return _mm_sqrt_ps(a); }
+		static F	Greater (F a, F b)		{ return _mm_cmpgt_ps(a, b); }
+		static F	And (F m, F a)			{ return _mm_and_ps(m, a); }
+		static F	Select (F m, F a, F b)		{ return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+
+		static I	Round (F a)			{ return _mm_cvtps_epi32(a); }
+		static F	ToFloat (I a)			{ return _mm_cvtepi32_ps(a); }
+		static I	Bits (F a)			{ return _mm_castps_si128(a); }
+		static F	FromBits (I a)			{ return _mm_castsi128_ps(a); }
+		static I	ISet (int i)			{ return _mm_set1_epi32(i); }
+		static I	IAdd (I a, I b)			{ return _mm_add_epi32(a, b); }
+		static I	ISub (I a, I b)			{ return _mm_sub_epi32(a, b); }
+		static I	IAnd (I a, I b)			{ return _mm_and_si128(a, b); }
+		static I	IOr (I a, I b)			{ return _mm_or_si128(a, b); }
+		static I	ExpToBits (I a)			{ return _mm_slli_epi32(a, 23); }
+		static I	BitsToExp (I a)			{ return _mm_srli_epi32(a, 23); }
+	};
+
+#ifdef __AVX2__
+	struct VecAVX2
+	{
+		typedef __m256		F;
+		typedef __m256i		I;
+		enum { WIDTH = 8 };
+
+		static F	Load (const float *p)		{ return _mm256_loadu_ps(p); }
+		static void	Store (float *p, F a)		{ _mm256_storeu_ps(p, a); }
+		static F	Set (float f)			{ return _mm256_set1_ps(f); }
+		static F	Add (F a, F b)			{ return _mm256_add_ps(a, b); }
+		static F	Sub (F a, F b)			{ return _mm256_sub_ps(a, b); }
+		static F	Mul (F a, F b)			{ return _mm256_mul_ps(a, b); }
+		static F	Div (F a, F b)			{ return _mm256_div_ps(a, b); }
+		static F	Min (F a, F b)			{ return _mm256_min_ps(a, b); }
+		static F	Max (F a, F b)			{ return _mm256_max_ps(a, b); }
+		static F	Sqrt (F a)			{ return _mm256_sqrt_ps(a); }
+		static F	Greater (F a, F b)		{ return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+		static F	And (F m, F a)			{ return _mm256_and_ps(m, a); }
+		static F	Select (F m, F a, F b)		{ return _mm256_blendv_ps(b, a, m); }
+
+		static I	Round (F a)			{ return _mm256_cvtps_epi32(a); }
+		static F	ToFloat (I a)			{ return _mm256_cvtepi32_ps(a); }
+		static I	Bits (F a)			{ return _mm256_castps_si256(a); }
+		static F	FromBits (I a)			{ return _mm256_castsi256_ps(a); }
+		static I	ISet (int i)			{ return _mm256_set1_epi32(i); }
+		static I	IAdd (I a, I b)			{ return _mm256_add_epi32(a, b); }
+		static I	ISub (I a, I b)			{ return _mm256_sub_epi32(a, b); }
+		static I	IAnd (I a, I b)			{ return _mm256_and_si256(a, b); }
+		static I	IOr (I a, I b)			{ return _mm256_or_si256(a, b); }
+		static I	ExpToBits (I a)			{ return _mm256_slli_epi32(a, 23); }
+		static I	BitsToExp (I a)			{ return _mm256_srli_epi32(a, 23); }
+	};
+#endif
+
+	template <class V>
+	static inline typename V::F Clamp01(typename V::F a)
+	{
+		return V::Min(V::Max(a, V::Set(0)), V::Set(1));
+	}
+
+	template <class V>
+	static inline typename V::F Lerp(typename V::F x, typename V::F y, typename V::F a)
+	{
+		return V::Add(x, V::Mul(a, V::Sub(y, x)));
+	}
+
+	/*
+	* log2 for positive x. The mantissa is folded into [sqrt(.5), sqrt(2))
+	* and log2 is taken from the atanh series in t = (m - 1) / (m + 1).
+	*/
+	template <class V>
+	static inline typename V::F FastLog2(typename V::F x)
+	{
+		typedef typename V::F	F;
+		typedef typename V::I	I;
+
+		I bits = V::Bits(x);
+		I e = V::ISub(V::BitsToExp(bits), V::ISet(127));
+		F m = V::FromBits(V::IOr(V::IAnd(bits, V::ISet(0x007FFFFF)), V::ISet(0x3F800000)));
+
+		F big = V::Greater(m, V::Set(1.41421356f));
+		m = V::Select(big, V::Mul(m, V::Set(0.5f)), m);
+		F ef = V::Add(V::ToFloat(e), V::And(big, V::Set(1.0f)));
+
+		F t = V::Div(V::Sub(m, V::Set(1.0f)), V::Add(m, V::Set(1.0f)));
+		F t2 = V::Mul(t, t);
+		F p = V::Add(V::Set(0.41219858f), V::Mul(t2, V::Set(0.32059889f)));	// 2/ln2 * 1/7, 1/9
+		p = V::Add(V::Set(0.57707802f), V::Mul(t2, p));					// 2/ln2 * 1/5
+		p = V::Add(V::Set(0.96179669f), V::Mul(t2, p));					// 2/ln2 * 1/3
+		p = V::Add(V::Set(2.88539008f), V::Mul(t2, p));					// 2/ln2
+
+		return V::Add(ef, V::Mul(t, p));
+	}
+
+	/*
+	* exp2 with round to nearest range reduction, so the polynomial only has
+	* to cover [-0.5, 0.5]. Results below 2^-126 flush to zero.
+	*/
+	template <class V>
+	static inline typename V::F FastExp2(typename V::F x)
+	{
+		typedef typename V::F	F;
+		typedef typename V::I	I;
+
+		F under = V::Greater(V::Set(-126.0f), x);
+		x = V::Min(V::Max(x, V::Set(-126.0f)), V::Set(127.0f));
+
+		I i = V::Round(x);
+		F f = V::Sub(x, V::ToFloat(i));
+
+		F p = V::Add(V::Set(1.3333558e-3f), V::Mul(f, V::Set(1.5403530e-4f)));	// ln2^5/5!, ln2^6/6!
+		p = V::Add(V::Set(9.6181291e-3f), V::Mul(f, p));					// ln2^4/4!
+		p = V::Add(V::Set(5.5504109e-2f), V::Mul(f, p));					// ln2^3/3!
+		p = V::Add(V::Set(0.24022651f), V::Mul(f, p));					// ln2^2/2!
+		p = V::Add(V::Set(0.69314718f), V::Mul(f, p));					// ln2
+		p = V::Add(V::Set(1.0f), V::Mul(f, p));
+
+		F scale = V::FromBits(V::ExpToBits(V::IAdd(i, V::ISet(127))));
+		return V::Select(under, V::Set(0.0f), V::Mul(p, scale));
+	}
+
+	/*
+	* pow(x, y) for x in [0, 1] and y > 0.
+	*/
+	template <class V>
+	static inline typename V::F FastPow(typename V::F x, typename V::F y)
+	{
+		typename V::F r = FastExp2<V>(V::Mul(y, FastLog2<V>(x)));
+
+		return V::And(V::Greater(x, V::Set(0.0f)), r);
+	}
+
+	/*
+	* Evaluate WIDTH samples starting at index i. Mirrors CoreShaderSample.
+	*/
+	template <class V>
+	static inline void ShaderLanes(const UnrealPacketArrays &in, const UnrealParmsArrays &out, unsigned i)
+	{
+		typedef typename V::F	F;
+
+		F one = V::Set(1.0f);
+		F half = V::Set(0.5f);
+
+		F metallic = Clamp01<V>(V::Load(in.metallic + i));
+		F specular = Clamp01<V>(V::Load(in.specular + i));
+		F roughness = Clamp01<V>(V::Load(in.roughness + i));
+		F uOpacity = Clamp01<V>(V::Load(in.uOpacity + i));
+		F tessMultiplier = Clamp01<V>(V::Load(in.tessMultiplier + i));
+
+		F mo = Clamp01<V>(V::Add(specular, specular));					// Micro occlusion darkening.
+		metallic = V::Mul(metallic, V::Mul(metallic, metallic));
+
+		V::Store(in.metallic + i, metallic);
+		V::Store(in.specular + i, specular);
+		V::Store(in.roughness + i, roughness);
+		V::Store(in.uOpacity + i, uOpacity);
+		V::Store(in.tessMultiplier + i, tessMultiplier);
+
+		for (int k = 0; k < 3; k++)
+		{
+			F bc = Clamp01<V>(V::Load(in.baseColor[k] + i));
+			F em = Clamp01<V>(V::Load(in.emissiveColor[k] + i));
+			F aux = Clamp01<V>(V::Load(in.auxRGB[k] + i));
+
+			V::Store(in.baseColor[k] + i, bc);
+			V::Store(in.emissiveColor[k] + i, em);
+			V::Store(in.auxRGB[k] + i, aux);
+
+			F rc3 = Lerp<V>(one, V::Sub(one, bc), half);
+			F rc4 = Lerp<V>(rc3, bc, metallic);
+
+			V::Store(out.diffCol[k] + i, V::Mul(bc, mo));
+			V::Store(out.specCol[k] + i, rc4);
+			V::Store(out.reflCol[k] + i, rc4);
+			V::Store(out.lumiCol[k] + i, em);
+		}
+
+		V::Store(out.diffAmt + i, Lerp<V>(one, half, metallic));
+
+		F sa1 = V::Sub(one, V::Sqrt(roughness));
+		F sa2 = Lerp<V>(V::Set(0.1f), one, sa1);
+		F sa11 = V::Sub(one, FastPow<V>(roughness, V::Set(0.7f)));
+		F sa12 = V::Mul(Lerp<V>(V::Set(0.05f), V::Set(0.1f), sa11), V::Add(specular, specular));
+		V::Store(out.specAmt + i, Lerp<V>(sa12, sa2, metallic));
+
+		F sr1 = Clamp01<V>(V::Mul(roughness, V::Set(4.0f)));
+		F sr2 = Lerp<V>(V::Set(0.08f), V::Set(0.008f), sr1);
+		F sr3 = FastPow<V>(roughness, sr2);
+		F sr4 = Lerp<V>(sr3, V::Sqrt(sr3), metallic);
+		F se = Lerp<V>(V::Set(10000.0f), one, sr4);
+		V::Store(out.rough + i, sr3);
+		V::Store(out.specExpU + i, se);
+		V::Store(out.specExpV + i, se);
+
+		F ra1 = Lerp<V>(one, half, roughness);
+		F ra2 = V::Mul(FastPow<V>(specular, V::Set(2.248f)), V::Set(0.19f));
+		V::Store(out.reflAmt + i, Lerp<V>(ra2, ra1, metallic));
+		V::Store(out.dissAmt + i, V::Sub(one, uOpacity));
+		V::Store(out.specFres + i, one);
+		V::Store(out.reflFres + i, one);
+		V::Store(out.driverA + i, specular);
+		V::Store(out.driverB + i, tessMultiplier);
+	}
+
+	/*
+	* Run the kernel over full vectors, then pad the remainder into a
+	* scratch block so the tail gets the same approximation.
+	*/
+	template <class V>
+	static void ShaderEvaluate(const UnrealPacketArrays &in, const UnrealParmsArrays &out, unsigned count)
+	{
+		enum { W = V::WIDTH };
+
+		unsigned	 i;
+
+		for (i = 0; i + W <= count; i += W)
+			ShaderLanes<V>(in, out, i);
+
+		if (i == count)
+			return;
+
+		unsigned		 n = count - i;
+		float			 pin[14][W];
+		float			 pout[23][W];
+		UnrealPacketArrays	 tin;
+		UnrealParmsArrays	 tout = { { 0 } };
+		float			*src[14];
+		float			*dst[23];
+
+		for (int k = 0; k < 3; k++)
+		{
+			src[k] = in.baseColor[k];
+			src[6 + k] = in.emissiveColor[k];
+			src[11 + k] = in.auxRGB[k];
+			tin.baseColor[k] = pin[k];
+			tin.emissiveColor[k] = pin[6 + k];
+			tin.auxRGB[k] = pin[11 + k];
+
+			dst[k] = out.diffCol[k];
+			dst[3 + k] = out.specCol[k];
+			dst[6 + k] = out.reflCol[k];
+			dst[9 + k] = out.lumiCol[k];
+			tout.diffCol[k] = pout[k];
+			tout.specCol[k] = pout[3 + k];
+			tout.reflCol[k] = pout[6 + k];
+			tout.lumiCol[k] = pout[9 + k];
+		}
+
+		src[3] = in.metallic;		tin.metallic = pin[3];
+		src[4] = in.specular;		tin.specular = pin[4];
+		src[5] = in.roughness;		tin.roughness = pin[5];
+		src[9] = in.uOpacity;		tin.uOpacity = pin[9];
+		src[10] = in.tessMultiplier;	tin.tessMultiplier = pin[10];
+
+		dst[12] = out.diffAmt;		tout.diffAmt = pout[12];
+		dst[13] = out.specAmt;		tout.specAmt = pout[13];
+		dst[14] = out.rough;		tout.rough = pout[14];
+		dst[15] = out.specExpU;		tout.specExpU = pout[15];
+		dst[16] = out.specExpV;		tout.specExpV = pout[16];
+		dst[17] = out.reflAmt;		tout.reflAmt = pout[17];
+		dst[18] = out.dissAmt;		tout.dissAmt = pout[18];
+		dst[19] = out.specFres;		tout.specFres = pout[19];
+		dst[20] = out.reflFres;		tout.reflFres = pout[20];
+		dst[21] = out.driverA;		tout.driverA = pout[21];
+		dst[22] = out.driverB;		tout.driverB = pout[22];
+
+		for (int k = 0; k < 14; k++)
+			for (int j = 0; j < W; j++)
+				pin[k][j] = j < (int)n ? src[k][i + j] : 0.0f;
+
+		ShaderLanes<V>(tin, tout, 0);
+
+		for (unsigned j = 0; j < n; j++)
+		{
+			for (int k = 0; k < 14; k++)
+				src[k][i + j] = pin[k][j];
+
+			for (int k = 0; k < 23; k++)
+				dst[k][i + j] = pout[k][j];
+		}
+	}
+
+	void CoreShaderEvaluateSSE(const UnrealPacketArrays &in, const UnrealParmsArrays &out, unsigned count)
+	{
+		ShaderEvaluate<VecSSE>(in, out, count);
+	}
+
+#ifdef __AVX2__
+	void CoreShaderEvaluateAVX2(const UnrealPacketArrays &in, const UnrealParmsArrays &out, unsigned count)
+	{
+		ShaderEvaluate<VecAVX2>(in, out, count);
+	}
+#endif
+
+	void CoreShaderEvaluateFast(const UnrealPacketArrays &in, const UnrealParmsArrays &out, unsigned count)
+	{
+#ifdef __AVX2__
+		ShaderEvaluate<VecAVX2>(in, out, count);
+#else
+		ShaderEvaluate<VecSSE>(in, out, count);
+#endif
+	}
+
+	/*
+	* Single sample version for the renderer, which hands us one sample at a
+	* time. The three approximated pow() calls share one SSE register.
+	*/
+	void CoreShaderSampleFast(LXpUnreal *sp, UnrealParms *parms)
+	{
+		CoreClampPacket(sp);
+
+		float mo = UNREAL_CLAMP(sp->specular * 2, 0, 1);				// Micro occlusion darkening.
+
+		parms->specFres = 1;
+		parms->reflFres = 1;
+
+		sp->metallic = sp->metallic * sp->metallic * sp->metallic;
+
+		for (int i = 0; i < 3; i++)
+		{
+			float rc1 = sp->baseColor[i];
+			float rc3 = LERP(1.0f, 1 - rc1, 0.5f);
+
+			parms->diffCol[i] = rc1 * mo;
+			parms->specCol[i] = LERP(rc3, rc1, sp->metallic);
+			parms->reflCol[i] = parms->specCol[i];
+			parms->lumiCol[i] = sp->emissiveColor[i];
+		}
+
+		float sr1 = UNREAL_CLAMP(sp->roughness * 4, 0, 1);
+		float sr2 = LERP(0.08f, 0.008f, sr1);
+
+		float	 pw[4];
+		__m128	 x = _mm_setr_ps(sp->roughness, sp->roughness, sp->specular, 1.0f);
+		__m128	 y = _mm_setr_ps(0.7f, sr2, 2.248f, 1.0f);
+
+		_mm_storeu_ps(pw, FastPow<VecSSE>(x, y));
+
+		parms->diffAmt = LERP(1.0f, 0.5f, sp->metallic);
+		float sa1 = 1 - sqrtf(sp->roughness);
+		float sa2 = LERP(0.1f, 1.0f, sa1);
+		float sa11 = 1 - pw[0];
+		float sa12 = LERP(0.05f, 0.1f, sa11) * (sp->specular * 2);
+		parms->specAmt = LERP(sa12, sa2, sp->metallic);
+
+		float sr3 = pw[1];
+		parms->rough = sr3;
+		float sr4 = LERP(sr3, sqrtf(sr3), sp->metallic);
+		parms->specExpU = LERP(10000.0f, 1.0f, sr4);
+		parms->specExpV = parms->specExpU;
+
+		float ra1 = LERP(1.0f, 0.5f, sp->roughness);
+		float ra2 = pw[2] * 0.19f;
+		parms->reflAmt = LERP(ra2, ra1, sp->metallic);
+		parms->dissAmt = 1 - sp->uOpacity;
+		parms->driverA = sp->specular;
+		parms->driverB = sp->tessMultiplier;
+	}
+
+};	// END namespace
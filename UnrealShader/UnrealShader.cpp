@@ -11,10 +11,13 @@
 #include <lx_raycast.hpp>
 #include <lx_shdr.hpp>
 #include <lx_tableau.hpp>
+#include <lxu_queries.hpp>
 
 #include <math.h>
 #include <string>
 
+#include "UnrealCore.h"
+
 
 namespace Unreal_Shader {	// disambiguate everything with a namespace
 
@@ -46,18 +49,7 @@ namespace Unreal_Shader {	// disambiguate everything with a namespace
 			{ 0 }
 	};
 
-	typedef struct st_LXpUnreal
-	{
-		LXtFVector	baseColor;
-		float metallic;
-		float specular;
-		float roughness;
-		LXtFVector	emissiveColor;
-		float uOpacity;
-		float tessMultiplier;
-		LXtFVector	auxRGB;
-	} LXpUnreal;
-
+	// LXpUnreal, the packet layout, is defined in UnrealCore.h.
 
 	unsigned int UnrealPacket::vpkt_Size(void)
 	{
@@ -144,6 +136,7 @@ namespace Unreal_Shader {	// disambiguate everything with a namespace
 		public:
 			bool		shaderMode;
 			bool		bakingMode;
+			int		remap;
 			LXtFVector	baseColor;
 			float metallic;
 			float specular;
@@ -208,6 +201,27 @@ namespace Unreal_Shader {	// disambiguate everything with a namespace
 		-1, 0
 	};
 
+	/*
+	* How shader mode converts the Unreal values, set by a user value.
+	*/
+	enum {
+		REMAP_EXACT = 0,
+		REMAP_FAST,
+		REMAP_END
+	};
+
+#define UNREAL_UV_REMAP			"unreal.remap"
+
+	static int ReadRemapPref()
+	{
+		CLxReadUserValue	 ruv;
+
+		if (ruv.Query(UNREAL_UV_REMAP))
+			return LXxCLAMP(ruv.GetInt(), 0, REMAP_END - 1);
+
+		return REMAP_EXACT;
+	}
+
 #define UNREAL_CH_SHADERMODE		"shaderMode"
 #define UNREAL_CH_BAKINGMODE		"bakingMode"
 #define UNREAL_CH_BASECOLOR			"baseColor"
@@ -381,6 +395,7 @@ namespace Unreal_Shader {	// disambiguate everything with a namespace
 
 		rd->shaderMode = at.Bool(idxs[0].layer);
 		rd->bakingMode = at.Bool(idxs[1].layer);
+		rd->remap = ReadRemapPref();
 
 		rd->baseColor[0] = at.Float(idxs[2].layer);
 		rd->baseColor[1] = at.Float(idxs[3].layer);
@@ -422,23 +437,63 @@ namespace Unreal_Shader {	// disambiguate everything with a namespace
 		return LXe_OK;
 	}
 
+	/*
+	* Copy the derived values into the sample packets. Each mode only touches
+	* the fields it sets in the core.
+	*/
+	static void SetShaderParms(LXpSampleParms *sParms, LXpSampleDriver *sDriver, const UnrealParms *parms)
+	{
+		sParms->specFres = parms->specFres;
+		sParms->reflFres = parms->reflFres;
+
+		LXx_VCPY(sParms->diffCol, parms->diffCol);
+		LXx_VCPY(sParms->specCol, parms->specCol);
+		LXx_VCPY(sParms->reflCol, parms->reflCol);
+		LXx_VCPY(sParms->lumiCol, parms->lumiCol);
+
+		sParms->diffAmt = parms->diffAmt;
+		sParms->specAmt = parms->specAmt;
+		sParms->rough = parms->rough;
+		sParms->specExpU = parms->specExpU;
+		sParms->specExpV = parms->specExpV;
+		sParms->reflAmt = parms->reflAmt;
+		sParms->dissAmt = parms->dissAmt;
+		sDriver->a = parms->driverA;
+		sDriver->b = parms->driverB;
+	}
+
+	static void SetBakingParms(LXpSampleParms *sParms, LXpSampleDriver *sDriver, const UnrealParms *parms)
+	{
+		sParms->specFres = parms->specFres;
+		sParms->reflFres = parms->reflFres;
+
+		LXx_VCPY(sParms->diffCol, parms->diffCol);
+		LXx_VCPY(sParms->specCol, parms->specCol);
+		LXx_VCPY(sParms->reflCol, parms->reflCol);
+		LXx_VCPY(sParms->lumiCol, parms->lumiCol);
+		LXx_VCPY(sParms->subsCol, parms->subsCol);
+		LXx_VCPY(sParms->tranCol, parms->tranCol);
+
+		sParms->diffAmt = parms->diffAmt;
+		sParms->specAmt = parms->specAmt;
+		sParms->rough = parms->rough;
+		sParms->reflAmt = parms->reflAmt;
+		sParms->tranAmt = parms->tranAmt;
+		sDriver->a = parms->driverA;
+		sDriver->b = parms->driverB;
+	}
+
 	/*
 	* Set custom material values at a spot
 	*/
 	void UnrealMaterial::cmt_MaterialEvaluate(ILxUnknownID etor, int *idx, ILxUnknownID vector, void *data)
 	{
-		#ifndef LERP
-			#define LERP(x,y,a)	((x) + (a) * ((y) - (x)))
-		#endif
-
 		RendData* rd = (RendData*)data;
 		LXpUnreal *sPacket = (LXpUnreal*)pkt_service.FastPacket(vector, pkt_offset);
 		LXpSampleParms *sParms = (LXpSampleParms*)pkt_service.FastPacket(vector, prm_offset);
 		LXpSampleDriver *sDriver = (LXpSampleDriver*)pkt_service.FastPacket(vector, drv_offset);
 		LXpSampleMask *sMask = (LXpSampleMask*)pkt_service.FastPacket(vector, msk_offset);
 		LXpDisplace *sDisp = (LXpDisplace*)pkt_service.FastPacket(vector, dis_offset);
-		LXtVector zero = { 0, 0, 0 };
-		LXtVector one = { 1, 1, 1 };
 
 		// Material properties to always modify:
 		sParms->flags |= LXfSURF_PHYSICAL;
@@ -449,93 +504,21 @@ namespace Unreal_Shader {	// disambiguate everything with a namespace
 
 		if (rd->shaderMode)
 		{
-			// Custom property pre-processing.
-			sPacket->baseColor[0] = LXxCLAMP(sPacket->baseColor[0], 0, 1);
-			sPacket->baseColor[1] = LXxCLAMP(sPacket->baseColor[1], 0, 1);
-			sPacket->baseColor[2] = LXxCLAMP(sPacket->baseColor[2], 0, 1);
-
-			sPacket->metallic = LXxCLAMP(sPacket->metallic, 0, 1);
-			sPacket->specular = LXxCLAMP(sPacket->specular, 0, 1);
-			sPacket->roughness = LXxCLAMP(sPacket->roughness, 0, 1);
-
-			sPacket->emissiveColor[0] = LXxCLAMP(sPacket->emissiveColor[0], 0, 1);
-			sPacket->emissiveColor[1] = LXxCLAMP(sPacket->emissiveColor[1], 0, 1);
-			sPacket->emissiveColor[2] = LXxCLAMP(sPacket->emissiveColor[2], 0, 1);
-
-			sPacket->uOpacity = LXxCLAMP(sPacket->uOpacity, 0, 1);
-			sPacket->tessMultiplier = LXxCLAMP(sPacket->tessMultiplier, 0, 1);
-
-			sPacket->auxRGB[0] = LXxCLAMP(sPacket->auxRGB[0], 0, 1);
-			sPacket->auxRGB[1] = LXxCLAMP(sPacket->auxRGB[1], 0, 1);
-			sPacket->auxRGB[2] = LXxCLAMP(sPacket->auxRGB[2], 0, 1);
-
-			float mo = LXxCLAMP(sPacket->specular * 2, 0, 1);			// Micro occlusion darkening.
+			UnrealParms	 parms;
 
 			if (rd->bakingMode)
 			{
-				sParms->specFres = 0;
-				sParms->reflFres = 0;
-
-				//LXx_VSET3(sParms->diffCol, sPacket->baseColor[0] * mo, sPacket->baseColor[1] * mo, sPacket->baseColor[2] * mo);
-				LXx_VSET3(sParms->diffCol, sPacket->baseColor[0], sPacket->baseColor[1], sPacket->baseColor[2]);
-				LXx_VSET3(sParms->specCol, sPacket->auxRGB[0], sPacket->auxRGB[1], sPacket->auxRGB[2]);
-				LXx_VSET3(sParms->reflCol, 1, 1, 1);
-				LXx_VSET3(sParms->lumiCol, sPacket->emissiveColor[0], sPacket->emissiveColor[1], sPacket->emissiveColor[2]);
-				LXx_VSET3(sParms->subsCol, sPacket->metallic, sPacket->roughness, sPacket->specular);
-				LXx_VSET3(sParms->tranCol, sPacket->uOpacity, sPacket->tessMultiplier, 0);
-
-				sParms->diffAmt = 1;
-				sParms->specAmt = 1;
-				sParms->rough = sPacket->roughness;
-				sParms->reflAmt = sPacket->metallic;
-				sParms->tranAmt = sPacket->uOpacity;
-				sDriver->a = sPacket->specular;
-				sDriver->b = sPacket->tessMultiplier;
+				CoreBakingSample(sPacket, &parms);
+				SetBakingParms(sParms, sDriver, &parms);
 			}
 			else
 			{
-				sParms->specFres = 1;
-				sParms->reflFres = 1;
-
-				sPacket->metallic = pow(sPacket->metallic, 3);
-
-				LXtVector rc1 = { sPacket->baseColor[0], sPacket->baseColor[1], sPacket->baseColor[2] };
-				LXx_VSET3(sParms->diffCol, rc1[0] * mo, rc1[1] * mo, rc1[2] * mo);			// Diffuse color.
-				LXtVector rc2 = { 1 - rc1[0], 1 - rc1[1], 1 - rc1[2] };
-				LXtVector rc3;
-				LXx_VLERP(rc3, one, rc2, 0.5);								// Diffuse color independent, always white specular.
-				LXtVector rc31;
-				LXx_VLERP(rc31, rc3, rc1, sPacket->metallic);				// Blend from white to colored specular.
-				LXx_VSET3(sParms->specCol, rc31[0], rc31[1], rc31[2]);		// Specular color.
-				LXtVector rc4;
-				LXx_VLERP(rc4, rc3, rc1, sPacket->metallic);				// Blending from white to colored reflection.
-				LXx_VSET3(sParms->reflCol, rc4[0], rc4[1], rc4[2]);			// Reflection color.
-				LXx_VSET3(sParms->lumiCol, sPacket->emissiveColor[0], sPacket->emissiveColor[1], sPacket->emissiveColor[2]);	// Emissive color.
-
-				sParms->diffAmt = LERP(1.0, 0.5, sPacket->metallic);		// Diffuse amount.
-				float sa1 = 1 - pow(sPacket->roughness, 0.5);
-				float sa2 = LERP(0.1, 1, sa1);
-				float sa11 = 1 - pow(sPacket->roughness, 0.7);
-				float sa12 = LERP(0.05, 0.1, sa11) * (sPacket->specular * 2);
-				sParms->specAmt = LERP(sa12, sa2, sPacket->metallic);					// Specular amount.
-
-				float sr1 = LXxCLAMP(sPacket->roughness * 4, 0, 1);
-				float sr2 = LERP(0.08, 0.008, sr1);
-				float sr3 = pow(sPacket->roughness, sr2);
-				sParms->rough = sr3;													// Roughness.
-				float sr4 = LERP(sr3, pow(sr3, 0.5), sPacket->metallic);
-				sParms->specExpU = LERP(10000, 1, sr4);									// Specular exponent U.
-				sParms->specExpV = LERP(10000, 1, sr4);									// Specular exponent V.
-
-				float ra1 = LERP(1, 0.5, sPacket->roughness);
-				float ra2 = LERP(0, 1, pow(sPacket->specular, 2.248) * 0.19);			// Should be 0.04 at 0.5.
-				sParms->reflAmt = LERP(ra2, ra1, sPacket->metallic);					// Reflection amount.
-				sParms->dissAmt = 1 - sPacket->uOpacity;								// Dissolve.
-				sDriver->a = sPacket->specular;											// Driver A.
-				sDriver->b = sPacket->tessMultiplier;									// Driver B.
-
-				// DEBUG
-				//LXx_VSET3(sParms->diffCol, sParms->reflAmt, sParms->reflAmt, sParms->reflAmt);
+				if (rd->remap == REMAP_FAST)
+					CoreShaderSampleFast(sPacket, &parms);
+				else
+					CoreShaderSample(sPacket, &parms);
+
+				SetShaderParms(sParms, sDriver, &parms);
 			}
 		}
 		else // Material mode